@@ -2,54 +2,54 @@
 #include <vector>
 #include <algorithm>
 #include <iomanip>
+#include <span>
+#include <type_traits>
+#include "partition_generators.h"
+#include "partition_function.h"
 
 using namespace std;
 
 class FerrersDiagramSolver {
-private:
-    // Biến chính: current - phân hoạch hiện tại trong quá trình sinh
-    // result - danh sách tất cả phân hoạch được sinh
-    void generatePartitionsRecursive(int n, int k, int minVal, 
-                                   vector<int>& current, 
-                                   vector<vector<int>>& result) {
-        // Base case: chỉ còn 1 phần
-        if (k == 1) {
-            if (n >= minVal) {
-                current.push_back(n);
-                result.push_back(current);
-                current.pop_back();
+public:
+    // Gọi visit(span<const int>) cho từng phân hoạch của n thành k phần,
+    // không cấp phát thêm gì ngoài bộ đệm k phần tử. Nếu visit trả về
+    // bool thì false nghĩa là dừng sớm.
+    template <class Visitor>
+    void forEachPartition(int n, int k, Visitor&& visit) {
+        for (PartitionCursor cursor(n, k); cursor.isValid(); cursor.next()) {
+            if constexpr (is_same_v<invoke_result_t<Visitor&, span<const int>>, bool>) {
+                if (!visit(cursor.current())) return;
+            }
+            else {
+                visit(cursor.current());
             }
-            return;
         }
-        
-        // Recursive case: thử các giá trị từ minVal đến n/k
-        // Điều kiện i <= n/k đảm bảo có thể phân phối đều
-        for (int i = minVal; i <= n/k; i++) {
-            current.push_back(i);
-            generatePartitionsRecursive(n - i, k - 1, i, current, result);
-            current.pop_back();
+    }
+
+    // Đếm p_k(n) chính xác, không duyệt phân hoạch nào. Bớt 1 ở mỗi phần:
+    // p_k(n) = số phân hoạch của n-k thành các phần <= k, nên khi 2k >= n
+    // thì đó chính là p(n-k), tính bằng công thức ngũ giác; ngược lại dùng
+    // hàng quy hoạch động của partitionsWithParts.
+    BigUnsigned countPartitions(int n, int k) {
+        if (k >= 1 && n >= k && 2 * k >= n) {
+            return PartitionFunction<BigUnsigned>(n - k).count(n - k);
         }
+        return *partitionsWithParts<BigUnsigned>(n, k);
     }
-    
-public:
-    // Hàm chính sinh tất cả phân hoạch của n thành k phần
+
+    // Hàm chính sinh tất cả phân hoạch của n thành k phần (lưu hết vào
+    // bộ nhớ; với n lớn nên dùng forEachPartition hoặc PartitionRange)
     vector<vector<int>> generatePartitions(int n, int k) {
         vector<vector<int>> result;
-        vector<int> current;
-        
-        generatePartitionsRecursive(n, k, 1, current, result);
-        
-        // Sắp xếp các phần theo thứ tự giảm dần (chuẩn partition)
-        for (auto& partition : result) {
-            sort(partition.rbegin(), partition.rend());
-        }
-        
+        forEachPartition(n, k, [&](span<const int> partition) {
+            result.emplace_back(partition.begin(), partition.end());
+        });
         return result;
     }
     
     // Hàm tính conjugate partition
     // conjugate[i] = số phần trong partition gốc có giá trị >= (i+1)
-    vector<int> computeConjugate(const vector<int>& partition) {
+    vector<int> computeConjugate(span<const int> partition) {
         if (partition.empty()) return {};
         
         vector<int> conjugate;
@@ -72,7 +72,7 @@ public:
     }
     
     // Hàm vẽ Ferrers diagram
-    void drawFerrersDiagram(const vector<int>& partition, const string& title) {
+    void drawFerrersDiagram(span<const int> partition, const string& title) {
         cout << title << ":" << endl;
         for (int part : partition) {
             for (int i = 0; i < part; i++) {
@@ -84,7 +84,7 @@ public:
     }
     
     // Hàm format partition để in
-    string formatPartition(const vector<int>& partition) {
+    string formatPartition(span<const int> partition) {
         if (partition.empty()) return "{}";
         
         string result = "(";
@@ -101,27 +101,27 @@ public:
         cout << "=== BÀI TOÁN 1: FERRERS & FERRERS TRANSPOSE DIAGRAMS ===" << endl;
         cout << "Tham số: n = " << n << ", k = " << k << endl << endl;
         
-        // Sinh tất cả phân hoạch
-        vector<vector<int>> partitions = generatePartitions(n, k);
+        // Đếm trước rồi duyệt lại, không giữ danh sách phân hoạch
         cout << "Số phân hoạch p_k(n) = p_" << k << "(" << n << ") = " 
-             << partitions.size() << endl << endl;
+             << countPartitions(n, k) << endl << endl;
         
         // Xử lý từng phân hoạch
-        for (size_t i = 0; i < partitions.size(); i++) {
-            cout << "--- PHÂN HOẠCH " << (i + 1) << " ---" << endl;
-            cout << "λ = " << formatPartition(partitions[i]) << endl << endl;
+        long long index = 0;
+        for (span<const int> partition : PartitionRange(n, k)) {
+            cout << "--- PHÂN HOẠCH " << ++index << " ---" << endl;
+            cout << "λ = " << formatPartition(partition) << endl << endl;
             
             // Vẽ Ferrers diagram gốc
-            drawFerrersDiagram(partitions[i], "Ferrers Diagram F");
+            drawFerrersDiagram(partition, "Ferrers Diagram F");
             
             // Tính và vẽ conjugate
-            vector<int> conjugate = computeConjugate(partitions[i]);
+            vector<int> conjugate = computeConjugate(partition);
             cout << "Conjugate λ^T = " << formatPartition(conjugate) << endl << endl;
             drawFerrersDiagram(conjugate, "Ferrers Transpose Diagram F^T");
             
             // Kiểm tra tính chất (λ^T)^T = λ
             vector<int> doubleConjugate = computeConjugate(conjugate);
-            bool isCorrect = (partitions[i] == doubleConjugate);
+            bool isCorrect = ranges::equal(partition, doubleConjugate);
             cout << "Kiểm tra (λ^T)^T = λ: " << (isCorrect ? "✓" : "✗") << endl;
             
             cout << string(50, '=') << endl << endl;
@@ -2,38 +2,27 @@
 #include <vector>
 #include <algorithm>
 #include <iomanip>
+#include <span>
+#include <optional>
+#include "partition_generators.h"
+#include "partition_numbers.h"
+#include "partition_function.h"
 
 using namespace std;
 
 class PartitionCountingSolver {
 private:
-    // Biến chính: dp[i][j] - số phân hoạch của i thành đúng j phần
-    vector<vector<int>> dp;
+    // Biến chính: dp[i][j] - số phân hoạch của i thành đúng j phần (bảng
+    // đầy đủ, chỉ dựng khi cần in ra)
+    vector<vector<long long>> dp;
     
-    void generatePartitionsRecursive(int n, int k, int minVal, 
-                                   vector<int>& current, 
-                                   vector<vector<int>>& result) {
-        if (k == 1) {
-            if (n >= minVal) {
-                current.push_back(n);
-                result.push_back(current);
-                current.pop_back();
-            }
-            return;
-        }
-        
-        for (int i = minVal; i <= n/k; i++) {
-            current.push_back(i);
-            generatePartitionsRecursive(n - i, k - 1, i, current, result);
-            current.pop_back();
-        }
-    }
+    // Bảng chỉ được in khi n nhỏ: bảng lớn vừa không đọc được vừa tốn
+    // O(n*k) bộ nhớ, và p(i,j) <= p(30) = 5604 nên long long không tràn
+    static const int kMaxTableN = 30;
     
-public:
-    // Hàm tính p(n,k) bằng Dynamic Programming
-    int computePartitionCountDP(int n, int k) {
+    void buildDPTable(int n, int k) {
         // Khởi tạo bảng DP
-        dp.assign(n + 1, vector<int>(k + 1, 0));
+        dp.assign(n + 1, vector<long long>(k + 1, 0));
         
         // Base cases
         // p(i,1) = 1: chỉ có 1 cách phân hoạch i thành 1 phần (chính là i)
@@ -54,44 +43,48 @@ public:
                 dp[i][j] = dp[i-1][j-1] + dp[i-j][j];
             }
         }
-        
-        return dp[n][k];
+    }
+    
+public:
+    // Hàm tính p(n,k) bằng Dynamic Programming (hàng trượt của
+    // partitionsWithParts) với kiểu giá trị tùy chọn: BigUnsigned (chính
+    // xác cho n hàng nghìn), long long, unsigned __int128 hoặc
+    // MontgomeryModInt (modulo nguyên tố, n tới 10^6).
+    // Kiểu có giới hạn mà bị tràn thì báo lỗi và trả về 0.
+    template <class Value = BigUnsigned>
+    Value computePartitionCountDP(int n, int k, int threads = 1) {
+        optional<Value> count = partitionsWithParts<Value>(n, k, threads);
+        if (!count) {
+            cout << "Lỗi: p(" << n << "," << k << ") vượt quá phạm vi của kiểu số đang dùng!" << endl;
+            return Value(0);
+        }
+        return *count;
     }
     
     // Hàm tính p_max(n,k) - số phân hoạch có phần tử lớn nhất là k
-    int computePartitionWithMax(int n, int maxVal) {
+    BigUnsigned computePartitionWithMax(int n, int maxVal) {
         if (maxVal > n) return 0;
         if (maxVal == n) return 1;
         
-        // Sinh tất cả phân hoạch và đếm những phân hoạch có max = maxVal
-        vector<vector<int>> allPartitions;
-        
-        // Sinh phân hoạch với tất cả số phần có thể
-        for (int parts = 1; parts <= n; parts++) {
-            vector<int> current;
-            vector<vector<int>> partitionsWithParts;
-            generatePartitionsRecursive(n, parts, 1, current, partitionsWithParts);
-            
-            // Sắp xếp và thêm vào danh sách tổng
-            for (auto& partition : partitionsWithParts) {
-                sort(partition.rbegin(), partition.rend());
-                allPartitions.push_back(partition);
-            }
-        }
-        
-        // Đếm số phân hoạch có max = maxVal
-        int count = 0;
-        for (const auto& partition : allPartitions) {
-            if (!partition.empty() && partition[0] == maxVal) {
-                count++;
-            }
+        // Bỏ phần lớn nhất đi còn một phân hoạch của n-maxVal với các phần
+        // <= maxVal; khi 2*maxVal >= n thì điều kiện này luôn đúng nên kết
+        // quả là p(n-maxVal), tính bằng công thức ngũ giác
+        if (2 * maxVal >= n) {
+            return PartitionFunction<BigUnsigned>(n - maxVal).count(n - maxVal);
         }
         
-        return count;
+        // Ngược lại đếm bằng hàng quy hoạch động: các phần <= maxVal của
+        // n-maxVal cũng chính là hàng mà partitionsWithParts(n, maxVal) tính
+        return *partitionsWithParts<BigUnsigned>(n, maxVal);
     }
     
     // In bảng Dynamic Programming
     void printDPTable(int n, int k) {
+        if (n > kMaxTableN) {
+            cout << "Bảng Dynamic Programming p(i,j) chỉ in khi n <= " << kMaxTableN << "." << endl << endl;
+            return;
+        }
+        buildDPTable(n, k);
         cout << "Bảng Dynamic Programming p(i,j):" << endl;
         
         // Header
@@ -117,13 +110,13 @@ public:
         cout << "=== BÀI TOÁN 2: ĐẾM SỐ PHÂN HOẠCH ===" << endl;
         cout << "Tham số: n = " << n << ", k = " << k << endl << endl;
         
-        // Tính p_k(n) bằng Dynamic Programming
-        int pk_n = computePartitionCountDP(n, k);
+        // Tính p_k(n) bằng Dynamic Programming, số nguyên lớn nên không tràn
+        BigUnsigned pk_n = computePartitionCountDP(n, k);
         cout << "p_" << k << "(" << n << ") = " << pk_n << endl;
         cout << "Giải thích: Số cách phân hoạch " << n << " thành đúng " << k << " phần" << endl << endl;
         
         // Tính p_max(n,k)
-        int pmax_n_k = computePartitionWithMax(n, k);
+        BigUnsigned pmax_n_k = computePartitionWithMax(n, k);
         cout << "p_max(" << n << "," << k << ") = " << pmax_n_k << endl;
         cout << "Giải thích: Số cách phân hoạch " << n << " có phần tử lớn nhất là " << k << endl << endl;
         
@@ -132,7 +125,7 @@ public:
         cout << "p_" << k << "(" << n << ") ";
         if (pk_n == pmax_n_k) {
             cout << "= ";
-        } else if (pk_n > pmax_n_k) {
+        } else if (pmax_n_k < pk_n) {
             cout << "> ";
         } else {
             cout << "< ";
@@ -150,21 +143,18 @@ public:
         // Verification bằng enumeration cho n,k nhỏ
         if (n <= 10 && k <= 6) {
             cout << "Verification bằng enumeration:" << endl;
-            vector<int> current;
-            vector<vector<int>> partitions;
-            generatePartitionsRecursive(n, k, 1, current, partitions);
+            int count = 0;
             
             cout << "Tất cả các phân hoạch:" << endl;
-            for (size_t i = 0; i < partitions.size(); i++) {
-                sort(partitions[i].rbegin(), partitions[i].rend());
-                cout << i + 1 << ". (";
-                for (size_t j = 0; j < partitions[i].size(); j++) {
-                    cout << partitions[i][j];
-                    if (j < partitions[i].size() - 1) cout << ",";
+            for (span<const int> partition : PartitionRange(n, k)) {
+                cout << ++count << ". (";
+                for (size_t j = 0; j < partition.size(); j++) {
+                    cout << partition[j];
+                    if (j < partition.size() - 1) cout << ",";
                 }
                 cout << ")" << endl;
             }
-            cout << "Tổng cộng: " << partitions.size() << " phân hoạch ✓" << endl << endl;
+            cout << "Tổng cộng: " << count << " phân hoạch ✓" << endl << endl;
         }
     }
 };
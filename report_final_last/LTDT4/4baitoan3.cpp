@@ -3,6 +3,9 @@
 #include <algorithm>
 #include <map>
 #include <iomanip>
+#include <span>
+#include "parallel_partitions.h"
+#include "partition_function.h"
 
 using namespace std;
 
@@ -11,25 +14,6 @@ private:
     // Biến chính: memo - bảng memoization cho đệ quy
     map<pair<int, int>, int> memo;
     
-    void generatePartitionsRecursive(int n, int k, int minVal, 
-                                   vector<int>& current, 
-                                   vector<vector<int>>& result) {
-        if (k == 1) {
-            if (n >= minVal) {
-                current.push_back(n);
-                result.push_back(current);
-                current.pop_back();
-            }
-            return;
-        }
-        
-        for (int i = minVal; i <= n/k; i++) {
-            current.push_back(i);
-            generatePartitionsRecursive(n - i, k - 1, i, current, result);
-            current.pop_back();
-        }
-    }
-    
     // Tính conjugate partition
     vector<int> computeConjugate(const vector<int>& partition) {
         if (partition.empty()) return {};
@@ -57,16 +41,47 @@ private:
         return partition == conjugate;
     }
     
+    // Kiểm tra self-conjugate ngay trên dạng bội {v_i, m_i} (v giảm dần):
+    // khối thứ i của λ^T có giá trị m_1+...+m_i và lặp v_i - v_(i+1) lần,
+    // nó phải trùng với khối thứ i tính từ cuối của λ
+    static bool isSelfConjugate(span<const PartBlock> blocks) {
+        int d = blocks.size();
+        int prefixCount = 0;
+        for (int i = 0; i < d; i++) {
+            prefixCount += blocks[i].count;
+            int nextValue = (i + 1 < d) ? blocks[i + 1].value : 0;
+            const PartBlock& mirror = blocks[d - 1 - i];
+            if (mirror.value != prefixCount || mirror.count != blocks[i].value - nextValue) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // Visitor cho duyệt song song: mỗi worker giữ các phân hoạch tự liên hợp
+    // kèm chỉ số shard, sau khi gộp thì xếp theo shard để giữ thứ tự tuần tự
+    struct SelfConjugateCollector {
+        int shard = 0;
+        vector<pair<int, vector<int>>> found;
+        
+        void beginShard(int index) { shard = index; }
+        void operator()(span<const PartBlock> blocks) {
+            if (!isSelfConjugate(blocks)) return;
+            found.emplace_back(shard, vector<int>());
+            expandPartition(blocks, found.back().second);
+        }
+        void merge(const SelfConjugateCollector& other) {
+            found.insert(found.end(), other.found.begin(), other.found.end());
+        }
+    };
+    
 public:
     // Sinh tất cả phân hoạch
     vector<vector<int>> generatePartitions(int n, int k) {
         vector<vector<int>> result;
-        vector<int> current;
         
-        generatePartitionsRecursive(n, k, 1, current, result);
-        
-        for (auto& partition : result) {
-            sort(partition.rbegin(), partition.rend());
+        for (span<const int> partition : PartitionRange(n, k)) {
+            result.emplace_back(partition.begin(), partition.end());
         }
         
         return result;
@@ -74,29 +89,35 @@ public:
     
     // Tìm tất cả phân hoạch self-conjugate có k phần
     vector<vector<int>> findSelfConjugatePartitions(int n, int k) {
-        vector<vector<int>> allPartitions = generatePartitions(n, k);
-        vector<vector<int>> selfConjugatePartitions;
+        // Duyệt song song ở dạng bội, chỉ trải ra mảng những phân hoạch thỏa mãn
+        SelfConjugateCollector collector =
+            parallelForEachPartitionWithParts(n, k, SelfConjugateCollector());
+        stable_sort(collector.found.begin(), collector.found.end(),
+                    [](const auto& a, const auto& b) { return a.first < b.first; });
         
-        for (const auto& partition : allPartitions) {
-            if (isSelfConjugate(partition)) {
-                selfConjugatePartitions.push_back(partition);
-            }
+        vector<vector<int>> selfConjugatePartitions;
+        for (auto& item : collector.found) {
+            selfConjugatePartitions.push_back(move(item.second));
         }
         
         return selfConjugatePartitions;
     }
     
     // Đếm số phân hoạch có số phần lẻ
-    int countPartitionsWithOddParts(int n) {
-        int count = 0;
-        
-        // Duyệt qua tất cả số phần lẻ từ 1 đến n
-        for (int parts = 1; parts <= n; parts += 2) {
-            vector<vector<int>> partitions = generatePartitions(n, parts);
-            count += partitions.size();
-        }
-        
-        return count;
+    BigUnsigned countPartitionsWithOddParts(int n) {
+        // Đánh dấu mỗi phần bằng -1: sum (-1)^(số phần) x^|λ| = prod 1/(1+x^i)
+        // = prod(1-x^i) * P(x^2), với P là chuỗi sinh của p(n). Hệ số e(n)
+        // = (#chẵn - #lẻ) chỉ cần p(0..n/2) và các số ngũ giác, nên
+        // #lẻ = (p(n) - e(n)) / 2 mà không phải duyệt phân hoạch nào.
+        // e(n) = plus - minus, giữ hai tổng riêng vì BigUnsigned không âm
+        PartitionFunction<BigUnsigned> partitions(n);
+        BigUnsigned plus = (n % 2 == 0) ? partitions.count(n / 2) : BigUnsigned(0);
+        BigUnsigned minus = 0;
+        forEachPentagonal(n, [&](int g, int sign) {
+            if ((n - g) % 2 == 0) (sign > 0 ? minus : plus) += partitions.count((n - g) / 2);
+        });
+        BigUnsigned odd = partitions.count(n) + minus - plus;
+        return odd /= 2;
     }
     
     // Đếm số phân hoạch thành các phần lẻ khác nhau
@@ -214,7 +235,7 @@ public:
         
         // (b) Đếm số phân hoạch có số phần lẻ
         cout << "Phần (b): Đếm số phân hoạch có số phần lẻ" << endl;
-        int oddPartsCount = countPartitionsWithOddParts(n);
+        BigUnsigned oddPartsCount = countPartitionsWithOddParts(n);
         cout << "Số phân hoạch của " << n << " có số phần lẻ: " << oddPartsCount << endl << endl;
         
         // So sánh với định lý
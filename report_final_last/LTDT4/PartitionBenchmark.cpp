@@ -0,0 +1,286 @@
+// Đo tốc độ sinh phân hoạch (số phân hoạch / giây) của các bộ sinh trong
+// partition_generators.h so với cách sinh đệ quy cũ của LTDT4.
+//
+// Mỗi dòng CSV ứng với một (bài toán, n, k, phương pháp):
+//
+//   task,n,k,method,partitions,total_ms,partitions_per_second,complete,checksum
+//
+// task = all: mọi phân hoạch của n (đệ quy chạy k = 1..n như
+// computePartitionWithMax cũ); task = fixed: đúng k = n/4 phần.
+// Đệ quy được đo đúng như code cũ ở mỗi lá (chép current ra vector rồi sắp
+// xếp giảm dần) nhưng không lưu lại, nếu không thì n lớn sẽ hết bộ nhớ.
+// Mỗi phép đo dừng sau --limit phân hoạch (complete = 0); checksum là
+// tổng các phần lớn nhất, giống nhau giữa các phương pháp khi complete = 1.
+// parallel_* (parallel_partitions.h, --threads worker) không dừng giữa chừng
+// nên chỉ chạy khi bản tuần tự tương ứng đã duyệt hết.
+//
+// task = count: p_k(n) với k = n/4 và n = 100, 400, 1500, 5000 không cần
+// duyệt (partitionsWithParts), một dòng cho mỗi kiểu số: dp_int64,
+// dp_uint128, dp_biguint và dp_mod; cùng các n đó, p(n) (k = 0) theo công
+// thức ngũ giác (pentagonal_*, cùng các kiểu số) và bằng nghịch đảo chuỗi
+// mod 998244353 (series_mod, partitionsModulo). partitions = 0, checksum là
+// kết quả mod 998244353 (phải giống nhau giữa các phương pháp), complete = 0
+// nếu kiểu bị tràn.
+//
+// Build: g++ -std=c++20 -O2 -pthread PartitionBenchmark.cpp -o PartitionBenchmark
+// Usage: PartitionBenchmark [--max-n N] [--limit N] [--threads N] [--output file.csv]
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <chrono>
+#include <optional>
+#include <charconv>
+#include "parallel_partitions.h"
+#include "partition_function.h"
+
+using namespace std;
+
+struct BenchmarkOptions {
+    int maxN = 120;
+    long long limit = 100000000;  // 0 = không giới hạn
+    int threads = 0;              // 0 = số nhân của máy
+    string output;
+};
+
+void printUsage() {
+    cout << "Usage: PartitionBenchmark [--max-n N] [--limit N] [--threads N] [--output file.csv]" << endl;
+}
+
+// Đọc cả chuỗi text thành số không âm kiểu Int (không dấu, không ký tự thừa)
+template <class Int>
+bool parseNumber(const string& text, Int& value) {
+    auto parsed = from_chars(text.data(), text.data() + text.size(), value);
+    return parsed.ec == errc() && parsed.ptr == text.data() + text.size() && !text.empty() && text[0] != '-';
+}
+
+bool parseOptions(int argc, char* argv[], BenchmarkOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cout << "Lỗi: thiếu giá trị cho " << arg << "!" << endl;
+            printUsage();
+            return false;
+        }
+        string value = argv[++i];
+        bool valid = true;
+        if (arg == "--max-n") valid = parseNumber(value, options.maxN);
+        else if (arg == "--limit") valid = parseNumber(value, options.limit);
+        else if (arg == "--threads") valid = parseNumber(value, options.threads);
+        else if (arg == "--output") options.output = value;
+        else {
+            cout << "Lỗi: tham số không hợp lệ " << arg << "!" << endl;
+            printUsage();
+            return false;
+        }
+        if (!valid) {
+            cout << "Lỗi: giá trị \"" << value << "\" không hợp lệ cho " << arg << "!" << endl;
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+// Kết quả một lần đo
+struct Measurement {
+    long long partitions = 0;
+    unsigned long long checksum = 0;
+    bool complete = true;
+};
+
+// Đếm và cộng dồn, trả về false khi chạm giới hạn
+struct Counter {
+    Measurement& result;
+    long long limit;
+
+    bool visit(int largestPart) {
+        result.partitions++;
+        result.checksum += largestPart;
+        if (limit > 0 && result.partitions >= limit) {
+            result.complete = false;
+            return false;
+        }
+        return true;
+    }
+};
+
+// Cách sinh đệ quy cũ (dãy không giảm), mỗi lá chép ra và sắp xếp giảm dần
+bool recursivePartitions(int n, int k, int minVal, vector<int>& current,
+                         vector<int>& sorted, Counter& counter) {
+    if (k == 1) {
+        if (n < minVal) return true;
+        current.push_back(n);
+        sorted = current;
+        sort(sorted.rbegin(), sorted.rend());
+        current.pop_back();
+        return counter.visit(sorted[0]);
+    }
+
+    for (int i = minVal; i <= n / k; i++) {
+        current.push_back(i);
+        bool keepGoing = recursivePartitions(n - i, k - 1, i, current, sorted, counter);
+        current.pop_back();
+        if (!keepGoing) return false;
+    }
+    return true;
+}
+
+Measurement runRecursion(int n, int firstK, int lastK, long long limit) {
+    Measurement result;
+    Counter counter{ result, limit };
+    vector<int> current, sorted;
+    for (int k = firstK; k <= lastK; k++) {
+        if (!recursivePartitions(n, k, 1, current, sorted, counter)) break;
+    }
+    return result;
+}
+
+template <class Generator>
+Measurement runGenerator(Generator generator, long long limit) {
+    Measurement result;
+    Counter counter{ result, limit };
+    for (; generator.isValid(); generator.next()) {
+        if (!counter.visit(generator.largestPart())) break;
+    }
+    return result;
+}
+
+Measurement runCursor(int n, int k, long long limit) {
+    Measurement result;
+    Counter counter{ result, limit };
+    for (span<const int> partition : PartitionRange(n, k)) {
+        if (!counter.visit(partition[0])) break;
+    }
+    return result;
+}
+
+// Visitor cho các driver song song, cùng checksum với Counter
+struct ParallelCounter {
+    long long partitions = 0;
+    unsigned long long checksum = 0;
+
+    void operator()(span<const PartBlock> blocks) {
+        partitions++;
+        checksum += blocks[0].value;
+    }
+    void merge(const ParallelCounter& other) {
+        partitions += other.partitions;
+        checksum += other.checksum;
+    }
+};
+
+Measurement toMeasurement(const ParallelCounter& counter) {
+    Measurement result;
+    result.partitions = counter.partitions;
+    result.checksum = counter.checksum;
+    return result;
+}
+
+// Số dư mod 998244353 của một kết quả đếm, cho mọi kiểu số
+template <class Value>
+unsigned long long residue(const Value& value) {
+    const uint32_t modulus = ModInt998244353::modulus();
+    if constexpr (is_same_v<Value, BigUnsigned>) return value.modulo(modulus);
+    else if constexpr (is_same_v<Value, ModInt998244353>) return value.value();
+    else return static_cast<unsigned long long>(value % modulus);
+}
+
+template <class Value>
+Measurement runCount(int n, int k) {
+    Measurement result;
+    optional<Value> count = partitionsWithParts<Value>(n, k);
+    result.complete = count.has_value();
+    if (count) result.checksum = residue(*count);
+    return result;
+}
+
+template <class Value>
+Measurement runPentagonal(int n) {
+    Measurement result;
+    PartitionFunction<Value> partitions(n);
+    result.complete = partitions.has(n);
+    if (result.complete) result.checksum = residue(partitions.count(n));
+    return result;
+}
+
+Measurement runSeries(int n) {
+    Measurement result;
+    result.checksum = partitionsModulo<ModInt998244353::modulus()>(n)[n].value();
+    return result;
+}
+
+template <class Run>
+Measurement measure(ostream& csv, const string& task, int n, int k, const string& method, Run run) {
+    auto start = chrono::steady_clock::now();
+    Measurement result = run();
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    double perSecond = ms > 0 ? result.partitions / (ms / 1000.0) : 0;
+
+    csv << task << "," << n << "," << k << "," << method << "," << result.partitions << ","
+        << ms << "," << (long long)perSecond << "," << (result.complete ? 1 : 0) << ","
+        << result.checksum << endl;
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            cout << "Lỗi: không ghi được " << options.output << "!" << endl;
+            return 1;
+        }
+    }
+    ostream& csv = options.output.empty() ? cout : file;
+    csv << "task,n,k,method,partitions,total_ms,partitions_per_second,complete,checksum" << endl;
+
+    long long limit = options.limit;
+    int threads = options.threads;
+    for (int n = 20; n <= options.maxN; n += 20) {
+        measure(csv, "all", n, 0, "recursion", [&] { return runRecursion(n, 1, n, limit); });
+        Measurement zs1 =
+            measure(csv, "all", n, 0, "zs1", [&] { return runGenerator(PartitionGeneratorZS1(n), limit); });
+        measure(csv, "all", n, 0, "zs2", [&] { return runGenerator(PartitionGeneratorZS2(n), limit); });
+        if (zs1.complete) {
+            measure(csv, "all", n, 0, "parallel_zs1", [&] {
+                return toMeasurement(parallelForEachPartition(n, ParallelCounter(), 0, threads));
+            });
+        }
+
+        int k = n / 4;
+        measure(csv, "fixed", n, k, "recursion", [&] { return runRecursion(n, k, k, limit); });
+        measure(csv, "fixed", n, k, "cursor", [&] { return runCursor(n, k, limit); });
+        Measurement fixed = measure(csv, "fixed", n, k, "fixed_parts",
+                                    [&] { return runGenerator(FixedPartsGenerator(n, k), limit); });
+        if (fixed.complete) {
+            measure(csv, "fixed", n, k, "parallel_fixed_parts", [&] {
+                return toMeasurement(parallelForEachPartitionWithParts(n, k, ParallelCounter(), threads));
+            });
+        }
+    }
+
+    for (int n : { 100, 400, 1500, 5000 }) {
+        int k = n / 4;
+        measure(csv, "count", n, k, "dp_int64", [&] { return runCount<long long>(n, k); });
+#ifdef __SIZEOF_INT128__
+        measure(csv, "count", n, k, "dp_uint128", [&] { return runCount<unsigned __int128>(n, k); });
+#endif
+        measure(csv, "count", n, k, "dp_biguint", [&] { return runCount<BigUnsigned>(n, k); });
+        measure(csv, "count", n, k, "dp_mod", [&] { return runCount<ModInt998244353>(n, k); });
+
+        measure(csv, "count", n, 0, "pentagonal_int64", [&] { return runPentagonal<long long>(n); });
+#ifdef __SIZEOF_INT128__
+        measure(csv, "count", n, 0, "pentagonal_uint128", [&] { return runPentagonal<unsigned __int128>(n); });
+#endif
+        measure(csv, "count", n, 0, "pentagonal_biguint", [&] { return runPentagonal<BigUnsigned>(n); });
+        measure(csv, "count", n, 0, "pentagonal_mod", [&] { return runPentagonal<ModInt998244353>(n); });
+        measure(csv, "count", n, 0, "series_mod", [&] { return runSeries(n); });
+    }
+    return 0;
+}
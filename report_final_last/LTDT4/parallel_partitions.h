@@ -0,0 +1,382 @@
+#ifndef PARALLEL_PARTITIONS_H
+#define PARALLEL_PARTITIONS_H
+
+// Duyệt phân hoạch song song: không gian tìm kiếm được chia thành các shard
+// theo một hoặc hai phần đầu, mỗi shard là một đoạn liền nhau của thứ tự
+// tuần tự. Các shard chạy trên một pool work-stealing, mỗi worker giữ một
+// visitor riêng, cuối cùng các visitor được gộp lại (merge).
+//
+// Visitor cần: sao chép được, operator()(std::span<const PartBlock>) và
+// merge(const Visitor&). Nếu có beginShard(int) thì được gọi trước mỗi
+// shard với chỉ số shard (tăng theo thứ tự tuần tự), để visitor có thể
+// sắp xếp lại kết quả lọc cho đúng thứ tự. prototype phải ở trạng thái
+// rỗng vì mỗi worker bắt đầu từ một bản sao của nó.
+//
+// Các bài đếm của 4baitoan1/2/3 dùng công thức đóng (partition_function.h)
+// nên không duyệt; ở đây chỉ còn findSelfConjugatePartitions (4baitoan3),
+// vốn phải liệt kê, và PartitionBenchmark.
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <span>
+#include <algorithm>
+#include "partition_generators.h"
+
+// Pool work-stealing đơn giản: mỗi worker một hàng đợi có khóa, lấy việc
+// ở đầu hàng của mình, hết việc thì lấy trộm ở cuối hàng của worker khác.
+// Mọi task đã biết trước nên worker thấy tất cả hàng đợi rỗng là xong.
+// Các thread worker được tạo một lần trong constructor và ngủ giữa các lần
+// run() (thread gọi run() là worker 0), nên một lần run() chỉ tốn một lần
+// đánh thức thay vì tạo và join threadCount - 1 thread.
+// Số thread thật sự ứng với tham số threads (0 = số nhân của máy)
+inline int partitionThreadCount(int threads) {
+    return threads > 0 ? threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+class WorkStealingPool {
+private:
+    struct WorkerQueue {
+        std::mutex lock;
+        std::deque<int> tasks;
+    };
+
+    int threadCount;
+    std::vector<WorkerQueue> queues;
+    std::vector<std::thread> workers;
+
+    // Lần run() hiện tại: body được gọi qua call(context, task, worker)
+    std::mutex runLock;  // mỗi lúc chỉ một run()
+    std::mutex stateLock;
+    std::condition_variable wake, finished;
+    void (*call)(void*, int, int) = nullptr;
+    void* context = nullptr;
+    unsigned long long generation = 0;
+    int busyWorkers = 0;
+    bool stopping = false;
+
+    bool takeTask(int worker, int& task) {
+        {
+            std::lock_guard<std::mutex> guard(queues[worker].lock);
+            if (!queues[worker].tasks.empty()) {
+                task = queues[worker].tasks.front();
+                queues[worker].tasks.pop_front();
+                return true;
+            }
+        }
+        for (int offset = 1; offset < threadCount; offset++) {
+            WorkerQueue& victim = queues[(worker + offset) % threadCount];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work(int worker) {
+        for (int task; takeTask(worker, task);) call(context, task, worker);
+    }
+
+    void workerLoop(int worker) {
+        unsigned long long seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> guard(stateLock);
+                wake.wait(guard, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+            work(worker);
+            std::lock_guard<std::mutex> guard(stateLock);
+            if (--busyWorkers == 0) finished.notify_one();
+        }
+    }
+
+public:
+    explicit WorkStealingPool(int threads = 0)
+        : threadCount(partitionThreadCount(threads)), queues(threadCount) {
+        for (int worker = 1; worker < threadCount; worker++) {
+            workers.emplace_back([this, worker] { workerLoop(worker); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> guard(stateLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int size() const { return threadCount; }
+
+    // Gọi body(task, worker) cho task = 0..taskCount-1 rồi chờ tất cả xong
+    template <class Body>
+    void run(int taskCount, Body&& body) {
+        if (threadCount == 1 || taskCount <= 1) {
+            for (int task = 0; task < taskCount; task++) body(task, 0);
+            return;
+        }
+
+        std::lock_guard<std::mutex> running(runLock);
+        for (int task = 0; task < taskCount; task++) {
+            std::lock_guard<std::mutex> guard(queues[task % threadCount].lock);
+            queues[task % threadCount].tasks.push_back(task);
+        }
+        {
+            std::lock_guard<std::mutex> guard(stateLock);
+            call = [](void* body, int task, int worker) {
+                (*static_cast<std::remove_reference_t<Body>*>(body))(task, worker);
+            };
+            context = &body;
+            busyWorkers = threadCount - 1;
+            generation++;
+        }
+        wake.notify_all();
+
+        work(0);
+        std::unique_lock<std::mutex> guard(stateLock);
+        finished.wait(guard, [&] { return busyWorkers == 0; });
+    }
+};
+
+// Pool dùng chung của các driver song song, một pool cho mỗi số thread
+// (0 = số nhân của máy), tạo ở lần gọi đầu và sống tới hết chương trình
+inline WorkStealingPool& sharedPartitionPool(int threads = 0) {
+    static std::mutex lock;
+    static std::map<int, std::unique_ptr<WorkStealingPool>> pools;
+    std::lock_guard<std::mutex> guard(lock);
+    std::unique_ptr<WorkStealingPool>& pool = pools[std::max(0, threads)];
+    if (!pool) pool = std::make_unique<WorkStealingPool>(threads);
+    return *pool;
+}
+
+// Gọi body(shard, worker) cho shard = 0..shardCount-1. Một shard thì chạy
+// ngay trên thread gọi, nên đầu vào nhỏ không tạo pool dùng chung (và các
+// thread của nó) chỉ để chạy một shard.
+template <class Body>
+void runShards(int shardCount, int threads, Body&& body) {
+    if (shardCount <= 1) {
+        for (int shard = 0; shard < shardCount; shard++) body(shard, 0);
+        return;
+    }
+    sharedPartitionPool(threads).run(shardCount, body);
+}
+
+// Visitor đếm đơn giản
+struct PartitionCounter {
+    long long count = 0;
+
+    void operator()(std::span<const PartBlock>) { count++; }
+    void merge(const PartitionCounter& other) { count += other.count; }
+};
+
+// Một shard: các phần cố định ở đầu thứ tự duyệt (rỗng = toàn bộ không
+// gian) và kích thước ước lượng
+struct PartitionShard {
+    std::vector<int> parts;
+    double size;
+};
+
+// Dưới ngưỡng này chạy tuần tự, đánh thức worker không đáng
+const double kParallelPartitionThreshold = 1 << 15;
+
+// Mỗi worker nhận khoảng kShardsPerThread shard để work-stealing cân bằng
+const int kShardsPerThread = 16;
+
+// Bảng đếm để cân bằng shard (double vì chỉ dùng để ước lượng, giá trị
+// thật có thể vượt 64 bit), chỉ lưu nửa tam giác j <= m:
+// exact(m, j) = p_j(m), số phân hoạch của m thành đúng j phần;
+// atMost(m, j) = số phân hoạch của m thành tối đa j phần
+//              = số phân hoạch của m có mọi phần <= j.
+struct PartitionCountTables {
+    int limit = 0;
+    std::vector<std::vector<double>> exactRows, atMostRows;
+
+    explicit PartitionCountTables(int n) : limit(n), exactRows(n + 1), atMostRows(n + 1) {
+        for (int m = 0; m <= n; m++) {
+            exactRows[m].assign(m + 1, 0);
+            atMostRows[m].assign(m + 1, 0);
+        }
+        exactRows[0][0] = 1;
+        for (int m = 1; m <= n; m++) {
+            for (int j = 1; j <= m; j++) exactRows[m][j] = exactRows[m - 1][j - 1] + exact(m - j, j);
+        }
+        for (int m = 0; m <= n; m++) {
+            double sum = 0;
+            for (int j = 0; j <= m; j++) atMostRows[m][j] = sum += exactRows[m][j];
+        }
+    }
+
+    double exact(int m, int j) const { return j <= m ? exactRows[m][j] : 0; }
+    double atMost(int m, int j) const { return atMostRows[m][std::min(j, m)]; }
+};
+
+// Bảng không phụ thuộc k hay số thread nên được giữ lại giữa các lần gọi,
+// chỉ tính lại (O(n^2)) khi cần n lớn hơn bảng đang có
+inline std::shared_ptr<const PartitionCountTables> partitionCountTables(int n) {
+    static std::mutex lock;
+    static std::shared_ptr<const PartitionCountTables> cached;
+    std::lock_guard<std::mutex> guard(lock);
+    if (!cached || cached->limit < n) cached = std::make_shared<const PartitionCountTables>(n);
+    return cached;
+}
+
+// Shard cho phân hoạch của n thành đúng k phần (thứ tự FixedPartsGenerator)
+// theo các phần nhỏ nhất. Shard nào lớn hơn phần chia đều thì tách tiếp
+// theo phần nhỏ kế tiếp; với k lớn, phần lớn phân hoạch có rất nhiều phần
+// 1 nên có shard cần cố định nhiều phần mới đủ nhỏ.
+inline std::vector<PartitionShard> shardsWithParts(int n, int k, int threads) {
+    if (k <= 0 || n < k) return {};
+
+    std::shared_ptr<const PartitionCountTables> tables = partitionCountTables(n);
+    double total = tables->exact(n, k);
+    if (threads <= 1 || total < kParallelPartitionThreshold) return { { {}, total } };
+
+    // Số phân hoạch của m thành đúng j phần có phần nhỏ nhất đúng bằng t
+    auto withSmallest = [&](int m, int j, int t) {
+        double atLeast = m - j * (t - 1) >= 0 ? tables->exact(m - j * (t - 1), j) : 0;
+        double above = m - j * t >= 0 ? tables->exact(m - j * t, j) : 0;
+        return atLeast - above;
+    };
+
+    double target = total / (threads * kShardsPerThread);
+    std::vector<PartitionShard> shards;
+    std::vector<int> prefix;
+    // rest = n trừ tổng prefix; shard chỉ tách được khi còn >= 2 phần tự do
+    auto split = [&](auto& self, int rest, double size) -> void {
+        int fixed = prefix.size();
+        if (size <= target || fixed + 2 > k) {
+            shards.push_back({ prefix, size });
+            return;
+        }
+        for (int t = prefix.empty() ? 1 : prefix.back(); t * (k - fixed) <= rest; t++) {
+            double childSize = withSmallest(rest, k - fixed, t);
+            if (childSize <= 0) continue;
+            prefix.push_back(t);
+            self(self, rest - t, childSize);
+            prefix.pop_back();
+        }
+    };
+    split(split, n, total);
+    return shards;
+}
+
+// Shard cho mọi phân hoạch của n (thứ tự ZS1): theo phần lớn nhất m, shard
+// lớn được chia tiếp theo phần lớn thứ hai (vậy là đã đủ đều vì phần lớn
+// nhất phân bố rộng). largestPart > 0 chỉ giữ m đó.
+inline std::vector<PartitionShard> shardsAllPartitions(int n, int largestPart, int threads) {
+    if (n <= 0 || largestPart > n) return {};
+
+    std::shared_ptr<const PartitionCountTables> tables = partitionCountTables(n);
+    int firstM = largestPart > 0 ? largestPart : n;
+    int lastM = largestPart > 0 ? largestPart : 1;
+    double total = 0;
+    for (int m = firstM; m >= lastM; m--) total += tables->atMost(n - m, m);
+    if (threads <= 1 || total < kParallelPartitionThreshold) {
+        if (largestPart > 0) return { { { largestPart }, total } };
+        return { { {}, total } };
+    }
+
+    double target = total / (threads * kShardsPerThread);
+    std::vector<PartitionShard> shards;
+    for (int m = firstM; m >= lastM; m--) {
+        double size = tables->atMost(n - m, m);
+        if (size <= target || n == m) {
+            shards.push_back({ { m }, size });
+            continue;
+        }
+        for (int t = std::min(m, n - m); t >= 1; t--) {
+            shards.push_back({ { m, t }, tables->atMost(n - m - t, t) });
+        }
+    }
+    return shards;
+}
+
+template <class Visitor>
+void beginShard(Visitor& visitor, int shard) {
+    if constexpr (requires { visitor.beginShard(shard); }) visitor.beginShard(shard);
+}
+
+template <class Visitor>
+Visitor mergeVisitors(std::vector<Visitor>& visitors) {
+    Visitor result = visitors[0];
+    for (size_t worker = 1; worker < visitors.size(); worker++) result.merge(visitors[worker]);
+    return result;
+}
+
+// Duyệt song song các phân hoạch của n thành đúng k phần
+template <class Visitor>
+Visitor parallelForEachPartitionWithParts(int n, int k, const Visitor& prototype, int threads = 0) {
+    int threadCount = partitionThreadCount(threads);
+    std::vector<PartitionShard> shards = shardsWithParts(n, k, threadCount);
+    std::vector<Visitor> visitors(shards.size() > 1 ? threadCount : 1, prototype);
+
+    runShards(shards.size(), threads, [&](int index, int worker) {
+        Visitor& visitor = visitors[worker];
+        const PartitionShard& shard = shards[index];
+        beginShard(visitor, index);
+
+        if (shard.parts.empty()) {
+            for (FixedPartsGenerator generator(n, k); generator.isValid(); generator.next()) {
+                visitor(generator.blocks());
+            }
+            return;
+        }
+
+        // Shard kết thúc khi next() đụng tới một trong các phần cố định
+        int fixed = shard.parts.size();
+        for (FixedPartsGenerator generator(n, k, shard.parts); generator.isValid(); generator.next()) {
+            if (generator.firstChangedPart() < fixed) break;
+            visitor(generator.blocks());
+        }
+    });
+    return mergeVisitors(visitors);
+}
+
+// Duyệt song song mọi phân hoạch của n, hoặc chỉ những phân hoạch có phần
+// lớn nhất bằng largestPart nếu largestPart > 0
+template <class Visitor>
+Visitor parallelForEachPartition(int n, const Visitor& prototype, int largestPart = 0, int threads = 0) {
+    int threadCount = partitionThreadCount(threads);
+    std::vector<PartitionShard> shards = shardsAllPartitions(n, largestPart, threadCount);
+    std::vector<Visitor> visitors(shards.size() > 1 ? threadCount : 1, prototype);
+
+    runShards(shards.size(), threads, [&](int index, int worker) {
+        Visitor& visitor = visitors[worker];
+        const PartitionShard& shard = shards[index];
+        beginShard(visitor, index);
+
+        if (shard.parts.empty()) {
+            for (PartitionGeneratorZS1 generator(n); generator.isValid(); generator.next()) {
+                visitor(generator.blocks());
+            }
+            return;
+        }
+
+        auto inShard = [&](const PartitionGeneratorZS1& generator) {
+            for (size_t i = 0; i < shard.parts.size(); i++) {
+                if (generator.partAt(i) != shard.parts[i]) return false;
+            }
+            return true;
+        };
+        for (PartitionGeneratorZS1 generator(n, shard.parts); generator.isValid(); generator.next()) {
+            if (!inShard(generator)) break;
+            visitor(generator.blocks());
+        }
+    });
+    return mergeVisitors(visitors);
+}
+
+#endif  // PARALLEL_PARTITIONS_H
@@ -0,0 +1,237 @@
+#ifndef PARTITION_FUNCTION_H
+#define PARTITION_FUNCTION_H
+
+// Hàm phân hoạch p(n) không cần liệt kê:
+// - PartitionFunction<Value>: p(0..N) theo định lý số ngũ giác của Euler,
+//   O(N√N) phép cộng/trừ, với mọi kiểu số của partition_numbers.h;
+// - partitionsModulo<Modulus>: p(0..N) mod một số nguyên tố NTT bằng cách
+//   nghịch đảo chuỗi lũy thừa của tích Euler, O(N log N);
+// - partitionsWithParts<Value>: p_k(n) bằng một hàng quy hoạch động trượt,
+//   O((n-k)k), cũng với mọi kiểu số.
+// Ba chương trình in giá trị chính xác nên chỉ dùng BigUnsigned: p(n) mất
+// khoảng 0.36 s ở n = 5·10^4 và 1.5 s ở 10^5, còn partitionsModulo cho
+// p(0..10^6) mod 998244353 trong khoảng 0.34 s nhưng chỉ PartitionBenchmark
+// dùng tới (các chương trình còn liệt kê phân hoạch, nên n thực tế nhỏ hơn
+// nhiều).
+
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <optional>
+#include <thread>
+#include <barrier>
+#include <atomic>
+#include "partition_numbers.h"
+
+// Gọi visit(g, sign) cho các số ngũ giác suy rộng g = k(3k∓1)/2 <= limit
+// (k = 1, 2, ...), theo thứ tự tăng, sign = +1 nếu k lẻ, -1 nếu k chẵn.
+// Tích Euler: prod(1 - x^i) = 1 - sum sign * x^g.
+template <class Visit>
+void forEachPentagonal(int limit, Visit&& visit) {
+    for (long long k = 1;; k++) {
+        long long first = k * (3 * k - 1) / 2;
+        if (first > limit) return;
+        int sign = (k % 2 == 1) ? 1 : -1;
+        visit(static_cast<int>(first), sign);
+        long long second = k * (3 * k + 1) / 2;
+        if (second <= limit) visit(static_cast<int>(second), sign);
+    }
+}
+
+// p(0..limit) bằng công thức truy hồi ngũ giác:
+//     p(n) = sum sign(g) * p(n - g)   (g là số ngũ giác suy rộng <= n)
+// Các số hạng dương và âm được cộng riêng rồi trừ, nên kiểu không dấu và
+// BigUnsigned cũng dùng được. Với kiểu có giới hạn, bảng dừng ngay khi
+// một tổng trung gian bị tràn (sớm hơn chút so với giới hạn thật của p(n),
+// ví dụ long long tới 388); maxN() cho biết bảng tới đâu.
+template <class Value>
+class PartitionFunction {
+private:
+    std::vector<Value> values;
+
+public:
+    explicit PartitionFunction(int limit) {
+        if (limit < 0) return;
+        values.reserve(limit + 1);
+        values.push_back(Value(1));
+
+        for (int n = 1; n <= limit; n++) {
+            Value positive(0), negative(0);
+            bool overflow = false;
+            forEachPentagonal(n, [&](int g, int sign) {
+                Value& sum = sign > 0 ? positive : negative;
+                if (!addChecked(sum, values[n - g])) overflow = true;
+            });
+            if (overflow) return;
+            positive -= negative;
+            values.push_back(positive);
+        }
+    }
+
+    int maxN() const { return static_cast<int>(values.size()) - 1; }
+    bool has(int n) const { return n >= 0 && n <= maxN(); }
+    const Value& count(int n) const { return values[n]; }
+    std::span<const Value> table() const { return values; }
+};
+
+// p_k(n), số phân hoạch của n thành đúng k phần. Thay bảng (n+1)x(k+1)
+// bằng một hàng trượt: bớt 1 ở mỗi phần thì p_k(n) = số phân hoạch của n-k
+// thành các phần <= k. Sau bước j, row[m] = số phân hoạch của m thành các
+// phần <= j, nên row[m] += row[m-j]. Bộ nhớ O(n-k), thời gian O((n-k)*k).
+// Kiểu có giới hạn mà bị tràn thì trả về nullopt.
+template <class Value>
+std::optional<Value> partitionsWithParts(int n, int k, int threads = 1) {
+    if (k <= 0 || n < k) return Value(0);
+
+    int rest = n - k;
+    int lastPart = std::min(k, rest);
+    std::vector<Value> row(rest + 1, Value(0));
+    row[0] = Value(1);
+
+    // Ở bước j, các m cùng số dư mod j tạo thành các chuỗi độc lập: mỗi
+    // thread lấy một dải số dư liền nhau rồi chờ nhau ở barrier
+    threads = std::max(1, threads);
+    std::atomic<bool> overflow(false);
+    std::barrier sync(threads);
+    auto work = [&](int worker) {
+        bool localOverflow = false;
+        for (int j = 1; j <= lastPart; j++) {
+            int from = (long long)j * worker / threads;
+            int to = (long long)j * (worker + 1) / threads;
+            for (int base = j; base + from <= rest; base += j) {
+                int end = std::min(base + to, rest + 1);
+                for (int m = base + from; m < end; m++) {
+                    if (!addChecked(row[m], row[m - j])) localOverflow = true;
+                }
+            }
+            if (threads > 1) sync.arrive_and_wait();
+        }
+        if (localOverflow) overflow = true;
+    };
+
+    std::vector<std::thread> workers;
+    for (int worker = 1; worker < threads; worker++) workers.emplace_back(work, worker);
+    work(0);
+    for (std::thread& worker : workers) worker.join();
+
+    if (overflow) return std::nullopt;
+    return row[rest];
+}
+
+// Bảng căn của đơn vị cho NTT: roots[half + i] = w^i với w là căn bậc
+// 2 * half của 1 (hoặc nghịch đảo của nó), mỗi tầng đọc một đoạn liền
+// nhau. Bảng chỉ phụ thuộc vào half nên được giữ lại và nới rộng dần.
+template <uint32_t Modulus, uint32_t PrimitiveRoot>
+const std::vector<MontgomeryModInt<Modulus>>& nttRoots(int size, bool invert) {
+    using ModInt = MontgomeryModInt<Modulus>;
+    thread_local std::vector<ModInt> tables[2];
+    std::vector<ModInt>& roots = tables[invert ? 1 : 0];
+
+    int half = std::max<int>(1, roots.size());
+    if (static_cast<int>(roots.size()) < size) roots.resize(size);
+    for (; half < size; half <<= 1) {
+        ModInt root = ModInt(PrimitiveRoot).pow((Modulus - 1) / (2 * half));
+        if (invert) root = root.inverse();
+        roots[half] = ModInt(1);
+        for (int i = 1; i < half; i++) roots[half + i] = roots[half + i - 1] * root;
+    }
+    return roots;
+}
+
+// NTT tại chỗ trên a (độ dài lũy thừa của 2) modulo nguyên tố
+// Modulus = c * 2^s + 1 có căn nguyên thủy PrimitiveRoot. Chiều xuôi là
+// DIF, trả kết quả theo thứ tự đảo bit; chiều ngược là DIT, nhận thứ tự
+// đảo bit và trả về thứ tự tự nhiên. Nhân từng điểm không quan tâm thứ
+// tự nên tích chập không cần bước đảo bit nào.
+template <uint32_t Modulus, uint32_t PrimitiveRoot = 3>
+void numberTheoreticTransform(std::vector<MontgomeryModInt<Modulus>>& a, bool invert) {
+    using ModInt = MontgomeryModInt<Modulus>;
+    int size = a.size();
+    if (size <= 1) return;
+    const std::vector<ModInt>& roots = nttRoots<Modulus, PrimitiveRoot>(size, invert);
+
+    if (!invert) {
+        for (int half = size >> 1; half >= 1; half >>= 1) {
+            const ModInt* twiddle = roots.data() + half;
+            for (int start = 0; start < size; start += 2 * half) {
+                ModInt* low = a.data() + start;
+                ModInt* high = low + half;
+                for (int i = 0; i < half; i++) {
+                    ModInt u = low[i];
+                    low[i] += high[i];
+                    high[i] = (u - high[i]) * twiddle[i];
+                }
+            }
+        }
+        return;
+    }
+
+    for (int half = 1; half < size; half <<= 1) {
+        const ModInt* twiddle = roots.data() + half;
+        for (int start = 0; start < size; start += 2 * half) {
+            ModInt* low = a.data() + start;
+            ModInt* high = low + half;
+            for (int i = 0; i < half; i++) {
+                ModInt v = high[i] * twiddle[i];
+                high[i] = low[i] - v;
+                low[i] += v;
+            }
+        }
+    }
+    ModInt scale = ModInt(size).inverse();
+    for (ModInt& value : a) value *= scale;
+}
+
+// Nghịch đảo chuỗi lũy thừa: b với a * b = 1 mod x^length (cần a[0] != 0).
+// Lặp Newton b <- b - (a * b - 1) * b, mỗi bước gấp đôi số hệ số đúng từ
+// known lên target. Chỉ cần tích vòng độ dài target: phần bị cuộn vòng
+// rơi vào known hệ số đầu, vốn đã biết (a * b = 1 ở đó).
+template <uint32_t Modulus, uint32_t PrimitiveRoot = 3>
+std::vector<MontgomeryModInt<Modulus>> inverseSeries(const std::vector<MontgomeryModInt<Modulus>>& a,
+                                                     int length) {
+    using ModInt = MontgomeryModInt<Modulus>;
+    std::vector<ModInt> b = { a[0].inverse() };
+
+    for (int known = 1; known < length; known <<= 1) {
+        int target = known << 1;
+        std::vector<ModInt> product(a.begin(), a.begin() + std::min<size_t>(target, a.size()));
+        std::vector<ModInt> fb = b;
+        product.resize(target);
+        fb.resize(target);
+        numberTheoreticTransform<Modulus, PrimitiveRoot>(product, false);
+        numberTheoreticTransform<Modulus, PrimitiveRoot>(fb, false);
+
+        // product = a * b; giữ hệ số [known, target) của a * b - 1
+        for (int i = 0; i < target; i++) product[i] *= fb[i];
+        numberTheoreticTransform<Modulus, PrimitiveRoot>(product, true);
+        std::fill(product.begin(), product.begin() + known, ModInt(0));
+
+        // (a * b - 1) * b, hệ số [known, target) là phần b còn thiếu (đổi dấu)
+        numberTheoreticTransform<Modulus, PrimitiveRoot>(product, false);
+        for (int i = 0; i < target; i++) product[i] *= fb[i];
+        numberTheoreticTransform<Modulus, PrimitiveRoot>(product, true);
+
+        b.resize(target);
+        for (int i = known; i < target; i++) b[i] = ModInt(0) - product[i];
+    }
+
+    b.resize(length);
+    return b;
+}
+
+// p(0..limit) mod Modulus: chuỗi sinh sum p(n) x^n = 1 / prod(1 - x^i),
+// còn tích Euler chỉ có O(√N) hệ số khác 0 (số ngũ giác)
+template <uint32_t Modulus, uint32_t PrimitiveRoot = 3>
+std::vector<MontgomeryModInt<Modulus>> partitionsModulo(int limit) {
+    using ModInt = MontgomeryModInt<Modulus>;
+    if (limit < 0) return {};
+
+    std::vector<ModInt> euler(limit + 1, ModInt(0));
+    euler[0] = ModInt(1);
+    forEachPentagonal(limit, [&](int g, int sign) {
+        euler[g] = sign > 0 ? ModInt(Modulus - 1) : ModInt(1);
+    });
+    return inverseSeries<Modulus, PrimitiveRoot>(euler, limit + 1);
+}
+
+#endif  // PARTITION_FUNCTION_H
@@ -0,0 +1,356 @@
+#ifndef PARTITION_GENERATORS_H
+#define PARTITION_GENERATORS_H
+
+// Các bộ sinh phân hoạch dùng chung cho ba bài toán LTDT4.
+// Tất cả đều sinh tại chỗ (không đệ quy, không sắp xếp lại), mỗi bước chỉ
+// sửa vài phần tử ở một đầu của bộ đệm.
+
+#include <vector>
+#include <span>
+#include <iterator>
+#include <cmath>
+#include <cstddef>
+
+// Một khối trong dạng bội (multiplicity form): giá trị phần và số lần lặp.
+// Phân hoạch (3,3,2,1,1,1) có dạng bội {3,2} {2,1} {1,3}.
+struct PartBlock {
+    int value;
+    int count;
+};
+
+// Trải dạng bội ra mảng các phần không tăng, dùng lại bộ đệm parts
+inline void expandPartition(std::span<const PartBlock> blocks, std::vector<int>& parts) {
+    parts.clear();
+    for (const PartBlock& block : blocks) {
+        parts.insert(parts.end(), block.count, block.value);
+    }
+}
+
+// Số khối tối đa của một phân hoạch của n: d(d+1)/2 <= n
+inline int maxDistinctParts(int n) {
+    return static_cast<int>(std::sqrt(2.0 * n)) + 2;
+}
+
+// ZS1 (Zoghbi–Stojmenović) ở dạng bội: mọi phân hoạch của n theo thứ tự
+// từ điển ngược, từ (n) xuống (1,1,...,1). Các khối giảm dần theo giá trị,
+// mỗi bước chỉ đụng tới hai khối cuối nên thời gian hằng số mỗi phân hoạch.
+class PartitionGeneratorZS1 {
+private:
+    std::vector<PartBlock> blockBuffer;
+    bool valid;
+
+    void pushPart(int value, int count) {
+        if (value <= 0 || count <= 0) return;
+        if (!blockBuffer.empty() && blockBuffer.back().value == value) {
+            blockBuffer.back().count += count;
+        }
+        else {
+            blockBuffer.push_back({value, count});
+        }
+    }
+
+public:
+    explicit PartitionGeneratorZS1(int n) : valid(n > 0) {
+        if (!valid) return;
+        blockBuffer.reserve(maxDistinctParts(n));
+        blockBuffer.push_back({n, 1});
+    }
+
+    // Bắt đầu từ phân hoạch đầu tiên (theo thứ tự trên) mở đầu bằng
+    // leadingParts (không tăng): phần còn lại chia thành các phần bằng phần
+    // cuối của leadingParts. Các phân hoạch cùng phần đầu nằm liền nhau.
+    PartitionGeneratorZS1(int n, std::span<const int> leadingParts) : valid(false) {
+        int rest = n;
+        for (int part : leadingParts) rest -= part;
+        if (leadingParts.empty() || rest < 0) return;
+
+        valid = true;
+        blockBuffer.reserve(maxDistinctParts(n));
+        for (int part : leadingParts) pushPart(part, 1);
+        int fill = leadingParts.back();
+        pushPart(fill, rest / fill);
+        pushPart(rest % fill, 1);
+    }
+
+    bool isValid() const { return valid; }
+    std::span<const PartBlock> blocks() const { return blockBuffer; }
+    int largestPart() const { return blockBuffer.front().value; }
+
+    // Phần thứ index theo thứ tự không tăng (0 = lớn nhất), 0 nếu không có
+    int partAt(int index) const {
+        for (const PartBlock& block : blockBuffer) {
+            if (index < block.count) return block.value;
+            index -= block.count;
+        }
+        return 0;
+    }
+
+    bool next() {
+        if (!valid) return false;
+
+        // Gom các phần 1 ở cuối, rồi bớt một bản của phần nhỏ nhất > 1
+        int ones = 0;
+        if (blockBuffer.back().value == 1) {
+            ones = blockBuffer.back().count;
+            blockBuffer.pop_back();
+        }
+        if (blockBuffer.empty()) {
+            valid = false;
+            return false;
+        }
+
+        int value = blockBuffer.back().value;
+        if (--blockBuffer.back().count == 0) blockBuffer.pop_back();
+
+        // Chia lại (value + ones) thành nhiều phần value-1 nhất có thể
+        int rest = ones + value;
+        int smaller = value - 1;
+        blockBuffer.push_back({smaller, rest / smaller});
+        if (rest % smaller > 0) blockBuffer.push_back({rest % smaller, 1});
+        return true;
+    }
+};
+
+// ZS2 ở dạng bội: mọi phân hoạch của n theo thứ tự từ điển tăng, từ
+// (1,1,...,1) lên (n). Tăng phần đầu của khối cuối cùng còn "dư" phía sau,
+// phần còn lại trở thành các phần 1 — cũng chỉ sửa hai khối cuối.
+class PartitionGeneratorZS2 {
+private:
+    std::vector<PartBlock> blockBuffer;
+    bool valid;
+
+public:
+    explicit PartitionGeneratorZS2(int n) : valid(n > 0) {
+        if (!valid) return;
+        blockBuffer.reserve(maxDistinctParts(n));
+        blockBuffer.push_back({1, n});
+    }
+
+    bool isValid() const { return valid; }
+    std::span<const PartBlock> blocks() const { return blockBuffer; }
+    int largestPart() const { return blockBuffer.front().value; }
+
+    bool next() {
+        if (!valid) return false;
+
+        // rest = tổng các phần đứng sau phần đầu tiên của khối target
+        int target = static_cast<int>(blockBuffer.size()) - 1;
+        int rest = (blockBuffer[target].count - 1) * blockBuffer[target].value;
+        if (rest == 0) {
+            if (target == 0) {
+                valid = false;
+                return false;
+            }
+            rest = blockBuffer[target].value;
+            target--;
+            rest += (blockBuffer[target].count - 1) * blockBuffer[target].value;
+        }
+
+        // Phần đầu của khối target tăng 1, lấy 1 đơn vị từ rest
+        int value = blockBuffer[target].value + 1;
+        blockBuffer.resize(target);
+        if (!blockBuffer.empty() && blockBuffer.back().value == value) {
+            blockBuffer.back().count++;
+        }
+        else {
+            blockBuffer.push_back({value, 1});
+        }
+        if (rest > 1) blockBuffer.push_back({1, rest - 1});
+        return true;
+    }
+};
+
+// Phân hoạch của n thành đúng k phần ở dạng bội, cùng thứ tự với
+// PartitionCursor (từ điển trên dãy không giảm a_1 <= ... <= a_k, tức
+// (n-k+1,1,...,1) đi trước). Các khối giảm dần được giữ ở cuối một mảng
+// k ô: mọi thay đổi xảy ra ở các khối lớn (đầu mảng), nên chỉ cần dời
+// chỉ số start thay vì chép lại cả mảng.
+class FixedPartsGenerator {
+private:
+    std::vector<PartBlock> blockBuffer;  // khối hợp lệ: [start, k)
+    int start;
+    int firstChanged;  // xem firstChangedPart()
+    bool valid;
+
+    void pushFront(PartBlock block) { blockBuffer[--start] = block; }
+
+    // Thêm count phần bằng value vào đầu, gộp nếu khối đầu cùng giá trị
+    void pushPart(int value, int count) {
+        if (count <= 0) return;
+        if (start < static_cast<int>(blockBuffer.size()) && blockBuffer[start].value == value) {
+            blockBuffer[start].count += count;
+        }
+        else {
+            pushFront({value, count});
+        }
+    }
+
+public:
+    FixedPartsGenerator(int n, int k)
+        : blockBuffer(k > 0 ? k : 0), start(k > 0 ? k : 0), firstChanged(k), valid(k > 0 && n >= k) {
+        if (!valid) return;
+        pushPart(1, k - 1);
+        pushPart(n - k + 1, 1);
+    }
+
+    // Bắt đầu từ phân hoạch đầu tiên (theo thứ tự trên) có các phần nhỏ
+    // nhất là smallestParts (tăng dần): các phần tiếp theo bằng phần cuối
+    // của smallestParts, phần lớn nhất nhận số dư. Các phân hoạch cùng các
+    // phần nhỏ nhất nằm liền nhau.
+    FixedPartsGenerator(int n, int k, std::span<const int> smallestParts)
+        : blockBuffer(k > 0 ? k : 0), start(k > 0 ? k : 0), firstChanged(k), valid(false) {
+        int fixed = smallestParts.size();
+        if (fixed == 0 || fixed >= k) return;
+
+        int fill = smallestParts.back();
+        int last = n - (k - 1 - fixed) * fill;
+        for (int part : smallestParts) last -= part;
+        if (last < fill) return;
+
+        valid = true;
+        for (int part : smallestParts) pushPart(part, 1);
+        pushPart(fill, k - 1 - fixed);
+        pushPart(last, 1);
+    }
+
+    bool isValid() const { return valid; }
+    std::span<const PartBlock> blocks() const {
+        return std::span<const PartBlock>(blockBuffer).subspan(start);
+    }
+    int largestPart() const { return blockBuffer[start].value; }
+
+    // Vị trí (theo thứ tự tăng, 0 = nhỏ nhất) của phần nhỏ nhất bị thay đổi
+    // ở lần next() vừa rồi: các phần trước vị trí này giữ nguyên
+    int firstChangedPart() const { return firstChanged; }
+
+    bool next() {
+        if (!valid) return false;
+
+        // Duyệt các khối từ lớn xuống nhỏ. Với khối (u, c) chỉ cần thử phần
+        // cuối cùng của nó (theo thứ tự tăng): tăng lên u+1 kéo theo mọi phần
+        // phía sau thành u+1, phần lớn nhất nhận số dư và phải >= u+1.
+        int end = static_cast<int>(blockBuffer.size());
+        int afterCount = blockBuffer[start].count;
+        int afterSum = blockBuffer[start].value * blockBuffer[start].count;
+        for (int p = start + 1; p < end; p++) {
+            PartBlock block = blockBuffer[p];
+            int value = block.value + 1;
+            int last = block.value + afterSum - value * afterCount;
+            if (last >= value) {
+                firstChanged = end - 1 - afterCount;
+                start = p + 1;
+                if (block.count > 1) pushFront({block.value, block.count - 1});
+                if (last == value) {
+                    pushFront({value, afterCount + 1});
+                }
+                else {
+                    pushFront({value, afterCount});
+                    pushFront({last, 1});
+                }
+                return true;
+            }
+            afterCount += block.count;
+            afterSum += block.value * block.count;
+        }
+        valid = false;
+        return false;
+    }
+};
+
+// Con trỏ duyệt lần lượt các phân hoạch của n thành đúng k phần ở dạng
+// mảng, chỉ giữ một mảng k phần tử được dùng lại (bộ nhớ O(k)). Mỗi
+// phân hoạch đã ở dạng chuẩn (các phần không tăng). Thứ tự sinh giống
+// cách sinh đệ quy cũ: xét dãy không giảm a_1 <= ... <= a_k (đọc parts
+// từ cuối lên), các dãy đi theo thứ tự từ điển. Đây là thuật toán H
+// (Hindenburg): phần lớn các bước chỉ chuyển 1 từ parts[0] sang parts[1].
+class PartitionCursor {
+private:
+    int k;
+    std::vector<int> parts;  // parts[0] >= parts[1] >= ... >= parts[k-1]
+    bool valid;
+
+public:
+    PartitionCursor(int n, int k) : k(k), valid(k > 0 && n >= k) {
+        if (!valid) return;
+        parts.assign(k, 1);
+        parts[0] = n - (k - 1);
+    }
+
+    bool isValid() const { return valid; }
+    std::span<const int> current() const { return parts; }
+
+    // Chuyển sang phân hoạch kế tiếp; trả về false khi đã hết
+    bool next() {
+        if (!valid) return false;
+        if (k < 2) {
+            valid = false;
+            return false;
+        }
+
+        // Bước nhanh: parts[1] còn tăng được mà vẫn <= parts[0]
+        if (parts[1] < parts[0] - 1) {
+            parts[0]--;
+            parts[1]++;
+            return true;
+        }
+
+        // Tìm j nhỏ nhất có parts[j] < parts[0] - 1, tăng nó lên x, gán
+        // parts[1..j-1] = x và dồn phần dư vào parts[0]
+        int j = 2;
+        int sum = parts[0] + parts[1] - 1;
+        while (j < k && parts[j] >= parts[0] - 1) {
+            sum += parts[j];
+            j++;
+        }
+        if (j >= k) {
+            valid = false;
+            return false;
+        }
+
+        int x = parts[j] + 1;
+        parts[j] = x;
+        for (j--; j > 0; j--) {
+            parts[j] = x;
+            sum -= x;
+        }
+        parts[0] = sum;
+        return true;
+    }
+};
+
+// Range các phân hoạch của n thành k phần, dùng được với range-for:
+//     for (span<const int> partition : PartitionRange(n, k)) { ... }
+// Mỗi span trỏ vào bộ đệm chung, chỉ hợp lệ đến lần lặp tiếp theo.
+class PartitionRange {
+private:
+    int n;
+    int k;
+
+public:
+    class iterator {
+    private:
+        PartitionCursor cursor;
+
+    public:
+        using value_type = std::span<const int>;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() : cursor(0, 0) {}
+        iterator(int n, int k) : cursor(n, k) {}
+
+        std::span<const int> operator*() const { return cursor.current(); }
+        iterator& operator++() {
+            cursor.next();
+            return *this;
+        }
+        void operator++(int) { cursor.next(); }
+        bool operator==(std::default_sentinel_t) const { return !cursor.isValid(); }
+    };
+
+    PartitionRange(int n, int k) : n(n), k(k) {}
+
+    iterator begin() const { return iterator(n, k); }
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+};
+
+#endif  // PARTITION_GENERATORS_H
@@ -0,0 +1,231 @@
+#ifndef PARTITION_NUMBERS_H
+#define PARTITION_NUMBERS_H
+
+// Các kiểu số dùng cho bảng đếm phân hoạch: số nguyên lớn tự viết (limb 32
+// bit), số học modulo nguyên tố dạng Montgomery, và phép cộng có kiểm tra
+// tràn cho các kiểu số nguyên có giới hạn (64 bit, unsigned __int128).
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <ostream>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+// Số nguyên không âm tùy ý độ dài, limb 32 bit, limb thấp đứng trước.
+// Bảng đếm chỉ cần cộng/trừ (trừ khi a >= b) và đổi sang thập phân.
+class BigUnsigned {
+private:
+    std::vector<uint32_t> limbs;  // rỗng = 0
+
+public:
+    BigUnsigned(unsigned long long value = 0) {
+        while (value > 0) {
+            limbs.push_back(static_cast<uint32_t>(value));
+            value >>= 32;
+        }
+    }
+
+    BigUnsigned& operator+=(const BigUnsigned& other) {
+        if (limbs.size() < other.limbs.size()) limbs.resize(other.limbs.size(), 0);
+        uint64_t carry = 0;
+        size_t i = 0;
+        for (; i < other.limbs.size(); i++) {
+            carry += static_cast<uint64_t>(limbs[i]) + other.limbs[i];
+            limbs[i] = static_cast<uint32_t>(carry);
+            carry >>= 32;
+        }
+        for (; carry > 0 && i < limbs.size(); i++) {
+            carry += limbs[i];
+            limbs[i] = static_cast<uint32_t>(carry);
+            carry >>= 32;
+        }
+        if (carry > 0) limbs.push_back(static_cast<uint32_t>(carry));
+        return *this;
+    }
+
+    // Yêu cầu *this >= other
+    BigUnsigned& operator-=(const BigUnsigned& other) {
+        int64_t borrow = 0;
+        for (size_t i = 0; i < limbs.size(); i++) {
+            int64_t current = static_cast<int64_t>(limbs[i]) - borrow -
+                              (i < other.limbs.size() ? other.limbs[i] : 0);
+            borrow = current < 0 ? 1 : 0;
+            limbs[i] = static_cast<uint32_t>(current + (borrow << 32));
+        }
+        while (!limbs.empty() && limbs.back() == 0) limbs.pop_back();
+        return *this;
+    }
+
+    // Chia nguyên cho một số nhỏ
+    BigUnsigned& operator/=(uint32_t divisor) {
+        uint64_t remainder = 0;
+        for (size_t i = limbs.size(); i-- > 0;) {
+            uint64_t current = (remainder << 32) | limbs[i];
+            limbs[i] = static_cast<uint32_t>(current / divisor);
+            remainder = current % divisor;
+        }
+        while (!limbs.empty() && limbs.back() == 0) limbs.pop_back();
+        return *this;
+    }
+
+    friend BigUnsigned operator+(BigUnsigned a, const BigUnsigned& b) { return a += b; }
+    friend BigUnsigned operator-(BigUnsigned a, const BigUnsigned& b) { return a -= b; }
+    bool operator==(const BigUnsigned& other) const { return limbs == other.limbs; }
+    bool operator<(const BigUnsigned& other) const {
+        if (limbs.size() != other.limbs.size()) return limbs.size() < other.limbs.size();
+        return std::lexicographical_compare(limbs.rbegin(), limbs.rend(), other.limbs.rbegin(), other.limbs.rend());
+    }
+
+    // Số dư khi chia cho modulus (để đối chiếu với kết quả modulo)
+    uint32_t modulo(uint32_t modulus) const {
+        uint64_t remainder = 0;
+        for (size_t i = limbs.size(); i-- > 0;) {
+            remainder = ((remainder << 32) | limbs[i]) % modulus;
+        }
+        return static_cast<uint32_t>(remainder);
+    }
+
+    std::string toString() const {
+        if (limbs.empty()) return "0";
+
+        // Chia liên tiếp cho 10^9, mỗi lần lấy ra 9 chữ số thấp
+        std::vector<uint32_t> rest = limbs;
+        std::vector<uint32_t> chunks;
+        while (!rest.empty()) {
+            uint64_t remainder = 0;
+            for (size_t i = rest.size(); i-- > 0;) {
+                uint64_t current = (remainder << 32) | rest[i];
+                rest[i] = static_cast<uint32_t>(current / 1000000000);
+                remainder = current % 1000000000;
+            }
+            chunks.push_back(static_cast<uint32_t>(remainder));
+            while (!rest.empty() && rest.back() == 0) rest.pop_back();
+        }
+
+        std::string result = std::to_string(chunks.back());
+        for (size_t i = chunks.size() - 1; i-- > 0;) {
+            std::string digits = std::to_string(chunks[i]);
+            result += std::string(9 - digits.size(), '0') + digits;
+        }
+        return result;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const BigUnsigned& value) {
+    return out << value.toString();
+}
+
+// Số học modulo một số nguyên tố lẻ Modulus < 2^30 ở dạng Montgomery
+// (lưu x * 2^32 mod Modulus): phép nhân không cần chia, chỉ nhân và dịch.
+template <uint32_t Modulus>
+class MontgomeryModInt {
+private:
+    static_assert(Modulus % 2 == 1 && Modulus < (1u << 30), "Modulus phải lẻ và < 2^30");
+
+    // -Modulus^(-1) mod 2^32 bằng lặp Newton, và 2^64 mod Modulus
+    static constexpr uint32_t negativeInverse() {
+        uint32_t inverse = Modulus;
+        for (int i = 0; i < 4; i++) inverse *= 2 - Modulus * inverse;
+        return -inverse;
+    }
+    static constexpr uint32_t kNegativeInverse = negativeInverse();
+    static constexpr uint32_t kR2 =
+        static_cast<uint32_t>((((uint64_t(1) << 32) % Modulus) * ((uint64_t(1) << 32) % Modulus)) % Modulus);
+
+    uint32_t residue;
+
+    // t * 2^(-32) mod Modulus với t < Modulus * 2^32
+    static uint32_t reduce(uint64_t t) {
+        uint32_t q = static_cast<uint32_t>(t) * kNegativeInverse;
+        uint32_t result = static_cast<uint32_t>((t + static_cast<uint64_t>(q) * Modulus) >> 32);
+        return result >= Modulus ? result - Modulus : result;
+    }
+
+public:
+    MontgomeryModInt(unsigned long long value = 0)
+        : residue(reduce((value % Modulus) * kR2)) {}
+
+    static constexpr uint32_t modulus() { return Modulus; }
+    uint32_t value() const { return reduce(residue); }
+
+    MontgomeryModInt& operator+=(const MontgomeryModInt& other) {
+        residue += other.residue;
+        if (residue >= Modulus) residue -= Modulus;
+        return *this;
+    }
+    MontgomeryModInt& operator-=(const MontgomeryModInt& other) {
+        residue += Modulus - other.residue;
+        if (residue >= Modulus) residue -= Modulus;
+        return *this;
+    }
+    MontgomeryModInt& operator*=(const MontgomeryModInt& other) {
+        residue = reduce(static_cast<uint64_t>(residue) * other.residue);
+        return *this;
+    }
+
+    friend MontgomeryModInt operator+(MontgomeryModInt a, const MontgomeryModInt& b) { return a += b; }
+    friend MontgomeryModInt operator-(MontgomeryModInt a, const MontgomeryModInt& b) { return a -= b; }
+    friend MontgomeryModInt operator*(MontgomeryModInt a, const MontgomeryModInt& b) { return a *= b; }
+    bool operator==(const MontgomeryModInt& other) const { return residue == other.residue; }
+
+    MontgomeryModInt pow(unsigned long long exponent) const {
+        MontgomeryModInt result(1), base = *this;
+        for (; exponent > 0; exponent >>= 1) {
+            if (exponent & 1) result *= base;
+            base *= base;
+        }
+        return result;
+    }
+
+    // Nghịch đảo theo định lý Fermat (Modulus nguyên tố)
+    MontgomeryModInt inverse() const { return pow(Modulus - 2); }
+};
+
+template <uint32_t Modulus>
+std::ostream& operator<<(std::ostream& out, const MontgomeryModInt<Modulus>& value) {
+    return out << value.value();
+}
+
+// 998244353 = 119 * 2^23 + 1: nguyên tố, hợp với NTT
+using ModInt998244353 = MontgomeryModInt<998244353>;
+
+#ifdef __SIZEOF_INT128__
+inline std::string toString(unsigned __int128 value) {
+    if (value == 0) return "0";
+    std::string digits;
+    while (value > 0) {
+        digits += static_cast<char>('0' + static_cast<int>(value % 10));
+        value /= 10;
+    }
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+inline std::ostream& operator<<(std::ostream& out, unsigned __int128 value) {
+    return out << toString(value);
+}
+#endif
+
+// Kiểu số nguyên có giới hạn (có thể tràn khi cộng)
+template <class Value>
+constexpr bool kBoundedInteger = std::is_integral_v<Value>
+#ifdef __SIZEOF_INT128__
+                                 || std::is_same_v<Value, unsigned __int128>
+#endif
+    ;
+
+// a += b, trả về false nếu tràn (a giữ nguyên); kiểu số lớn và modulo
+// không bao giờ tràn. Chỉ dùng cho giá trị không âm.
+template <class Value>
+bool addChecked(Value& a, const Value& b) {
+    if constexpr (kBoundedInteger<Value>) {
+        Value maxValue = Value(-1) > Value(0) ? Value(-1) : std::numeric_limits<Value>::max();
+        if (a > maxValue - b) return false;
+    }
+    a += b;
+    return true;
+}
+
+#endif  // PARTITION_NUMBERS_H
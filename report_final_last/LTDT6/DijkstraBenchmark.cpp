@@ -0,0 +1,390 @@
+// Shortest-path benchmark suite for DijkstraProject.cpp.
+//
+// Generates grid, random geometric, power-law and road-like graphs at
+// several scales from a fixed seed, runs every SSSP engine on the same
+// sources, then the point-to-point engines (bidirectional Dijkstra,
+// contraction hierarchy, ALT) on one random target per source, and writes
+// one CSV row per (graph, engine):
+//
+//   family,vertices,arcs,engine,queries,relaxations,total_ms,
+//   ns_per_relaxation,queries_per_second,peak_rss_kb,agrees,seed
+//
+// relaxations counts arcs scanned (relaxations attempted) over all
+// queries; the CH and ALT queries have no trace hooks, so for them it is
+// the settled vertex count. agrees says whether the engine's distances
+// match the lazy priority queue. The *_build rows time the CH and ALT
+// preprocessing (queries = 0). The contraction hierarchy is only built up
+// to --ch-max-vertices and never on the power-law graphs, where contracting
+// the hubs adds shortcuts quadratically in their degree (a minute already
+// at 10,000 vertices). peak_rss_kb is the process peak so far, so
+// it grows with the largest graph generated. Equal seeds give equal graphs,
+// sources and targets.
+//
+// Build: g++ -std=c++20 -O2 -pthread DijkstraBenchmark.cpp -o DijkstraBenchmark
+// Usage: DijkstraBenchmark [--seed N] [--queries N] [--max-vertices N]
+//                          [--threads N] [--landmarks N] [--ch-max-vertices N]
+//                          [--output file.csv]
+// --max-vertices is the largest scale run (at least 10000).
+
+#define DIJKSTRA_NO_MAIN
+#include "DijkstraProject.cpp"
+
+#include <cmath>
+
+#ifdef _WIN32
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+// Peak resident set size of this process in KB
+long long peakResidentKilobytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return -1;
+    return (long long)(counters.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;  // bytes on macOS
+#else
+    return usage.ru_maxrss;         // KB on Linux
+#endif
+#endif
+}
+
+// One generated graph: undirected edges (from, to, weight)
+struct GraphSpec {
+    string family;
+    int vertices;
+    vector<tuple<int, int, int>> edges;
+};
+
+// side x side 4-neighbour grid with uniform weights in [1, 1000]
+GraphSpec makeGrid(int targetVertices, mt19937& rng) {
+    int side = max(2, (int)sqrt((double)targetVertices));
+    GraphSpec spec = { "grid", side * side, {} };
+    for (int v = 0; v < spec.vertices; v++) {
+        if (v % side + 1 < side) spec.edges.emplace_back(v, v + 1, 1 + (int)(rng() % 1000));
+        if (v + side < spec.vertices) spec.edges.emplace_back(v, v + side, 1 + (int)(rng() % 1000));
+    }
+    return spec;
+}
+
+// Points uniform in the unit square, joined when closer than a radius that
+// gives an average degree of about 8; the weight is the distance in
+// thousandths. Neighbours are found through a grid of radius-sized cells.
+GraphSpec makeGeometric(int vertices, mt19937& rng) {
+    GraphSpec spec = { "geometric", vertices, {} };
+    const double averageDegree = 8;
+    double radius = sqrt(averageDegree / (3.14159265358979 * vertices));
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    vector<pair<double, double>> points(vertices);
+    for (auto& point : points) point = { unit(rng), unit(rng) };
+
+    int cells = max(1, (int)(1.0 / radius));
+    vector<vector<int>> cell(cells * cells);
+    auto cellOf = [&](double c) { return min(cells - 1, (int)(c * cells)); };
+    for (int v = 0; v < vertices; v++) {
+        cell[cellOf(points[v].second) * cells + cellOf(points[v].first)].push_back(v);
+    }
+
+    for (int u = 0; u < vertices; u++) {
+        int cx = cellOf(points[u].first), cy = cellOf(points[u].second);
+        for (int y = max(0, cy - 1); y <= min(cells - 1, cy + 1); y++) {
+            for (int x = max(0, cx - 1); x <= min(cells - 1, cx + 1); x++) {
+                for (int v : cell[y * cells + x]) {
+                    if (v <= u) continue;
+                    double dx = points[u].first - points[v].first, dy = points[u].second - points[v].second;
+                    double length = sqrt(dx * dx + dy * dy);
+                    if (length < radius) spec.edges.emplace_back(u, v, 1 + (int)(length * 1000));
+                }
+            }
+        }
+    }
+    return spec;
+}
+
+// Barabasi-Albert preferential attachment: every new vertex links to 4
+// earlier ones picked in proportion to their degree (uniform from the list
+// of edge endpoints), which gives a power-law degree distribution
+GraphSpec makePowerLaw(int vertices, mt19937& rng) {
+    const int links = 4;
+    GraphSpec spec = { "power_law", vertices, {} };
+    vector<int> endpoints;
+    for (int v = 1; v <= links && v < vertices; v++) {
+        for (int u = 0; u < v; u++) {
+            spec.edges.emplace_back(u, v, 1 + (int)(rng() % 1000));
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+    for (int v = links + 1; v < vertices; v++) {
+        for (int k = 0; k < links; k++) {
+            int u = endpoints[rng() % endpoints.size()];
+            spec.edges.emplace_back(u, v, 1 + (int)(rng() % 1000));
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+    return spec;
+}
+
+// Grid with a fifth of the local streets missing and travel times of
+// 100-200, crossed every 16 rows and columns by highways that are three
+// times faster: low degree, long shortest paths and a road hierarchy
+GraphSpec makeRoadLike(int targetVertices, mt19937& rng) {
+    const int highwaySpacing = 16;
+    int side = max(2, (int)sqrt((double)targetVertices));
+    GraphSpec spec = { "road_like", side * side, {} };
+    for (int v = 0; v < spec.vertices; v++) {
+        int r = v / side, c = v % side;
+        if (c + 1 < side) {
+            bool highway = r % highwaySpacing == 0;
+            if (highway || rng() % 5 != 0) {
+                int time = 100 + (int)(rng() % 101);
+                spec.edges.emplace_back(v, v + 1, highway ? time / 3 : time);
+            }
+        }
+        if (r + 1 < side) {
+            bool highway = c % highwaySpacing == 0;
+            if (highway || rng() % 5 != 0) {
+                int time = 100 + (int)(rng() % 101);
+                spec.edges.emplace_back(v, v + side, highway ? time / 3 : time);
+            }
+        }
+    }
+    return spec;
+}
+
+struct BenchmarkOptions {
+    unsigned seed = 12345;
+    int queries = 5;
+    int maxVertices = 1000000;
+    int threads = 0;    // 0 = one per hardware core
+    int landmarks = 8;  // ALT landmarks
+    int chMaxVertices = 100000;
+    string output;      // empty = stdout
+};
+
+void writeRow(ostream& csv, const GraphSpec& spec, long long arcs, const string& engine, size_t queries,
+              long long relaxations, double ms, bool agrees, const BenchmarkOptions& options) {
+    csv << spec.family << "," << spec.vertices << "," << arcs << "," << engine << ","
+        << queries << "," << relaxations << "," << ms << ","
+        << (relaxations ? ms * 1e6 / relaxations : 0) << "," << queries * 1000.0 / max(ms, 1e-9) << ","
+        << peakResidentKilobytes() << "," << (agrees ? "yes" : "no") << "," << options.seed << endl;
+}
+
+// Time one engine over all sources. run(q, trace) performs query q (from
+// sources[q]; the point-to-point engines also read targets[q]) under the
+// given trace policy and returns its distances: a pass with
+// CountingTrace gives the relaxations and the agreement check, then a
+// separate pass with NoTrace is timed.
+template <class Run>
+void benchmarkEngine(ostream& csv, const GraphSpec& spec, long long arcs, const string& engine,
+                     const vector<int>& sources, const vector<vector<int>>& expected,
+                     const BenchmarkOptions& options, Run&& run) {
+    long long relaxations = 0;
+    bool agrees = true;
+    for (size_t q = 0; q < sources.size(); q++) {
+        CountingTrace counters;
+        agrees = run((int)q, counters) == expected[q] && agrees;
+        relaxations += counters.scanned;
+    }
+
+    auto start = chrono::steady_clock::now();
+    for (size_t q = 0; q < sources.size(); q++) run((int)q, NoTrace());
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    writeRow(csv, spec, arcs, engine, sources.size(), relaxations, ms, agrees, options);
+}
+
+void benchmarkGraph(ostream& csv, const GraphSpec& spec, ThreadPool& pool, const BenchmarkOptions& options) {
+    SimpleGraph graph(spec.vertices);
+    graph.addEdges(spec.edges);
+    long long arcs = graph.adjacency().arcCount();
+
+    mt19937 rng(options.seed ^ (unsigned)spec.vertices);
+    vector<int> sources;
+    vector<vector<int>> expected;
+    for (int q = 0; q < options.queries; q++) {
+        sources.push_back((int)(rng() % spec.vertices));
+        expected.push_back(graph.dijkstra(sources.back()).first);
+    }
+
+    // The lazy queue is the reference, so its own check is trivially true
+    auto heapEngine = [&](HeapEngine engine) {
+        return [&graph, &sources, engine](int q, auto&& trace) { return graph.dijkstra(sources[q], engine, trace).first; };
+    };
+    benchmarkEngine(csv, spec, arcs, "lazy_queue", sources, expected, options, heapEngine(HeapEngine::LazyQueue));
+    benchmarkEngine(csv, spec, arcs, "binary_heap", sources, expected, options, heapEngine(HeapEngine::BinaryHeap));
+    benchmarkEngine(csv, spec, arcs, "quaternary_heap", sources, expected, options, heapEngine(HeapEngine::QuaternaryHeap));
+    benchmarkEngine(csv, spec, arcs, "octonary_heap", sources, expected, options, heapEngine(HeapEngine::OctonaryHeap));
+    benchmarkEngine(csv, spec, arcs, "dial_buckets", sources, expected, options, heapEngine(HeapEngine::DialBuckets));
+    benchmarkEngine(csv, spec, arcs, "radix_heap", sources, expected, options, heapEngine(HeapEngine::RadixHeap));
+
+    // Parallel engines count through a per-worker profiler instead of a trace
+    benchmarkEngine(csv, spec, arcs, "delta_stepping", sources, expected, options,
+        [&](int q, auto&& trace) {
+            if constexpr (is_same_v<decay_t<decltype(trace)>, CountingTrace>) {
+                SearchProfiler profiler;
+                vector<int> dist = graph.deltaStepping(sources[q], pool, 0, profiler).first;
+                trace.merge(profiler.total());
+                return dist;
+            }
+            else {
+                return graph.deltaStepping(sources[q], pool, 0).first;
+            }
+        });
+
+    // All sources in one multi-source call on the pool
+    {
+        SearchProfiler profiler;
+        DistanceMatrix matrix = graph.dijkstraBatch(sources, pool, MatrixLayout::ColumnMajor, profiler);
+        bool agrees = true;
+        for (size_t q = 0; q < sources.size(); q++) {
+            auto column = matrix.values.begin() + q * spec.vertices;
+            agrees = agrees && equal(column, column + spec.vertices, expected[q].begin());
+        }
+        auto start = chrono::steady_clock::now();
+        graph.dijkstraBatch(sources, pool, MatrixLayout::ColumnMajor);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        writeRow(csv, spec, arcs, "batch_all_sources", sources.size(), profiler.total().scanned, ms, agrees, options);
+    }
+
+    // Compact typed adjacency (weights fit in 16 bits); it has no trace
+    // hooks, so its relaxations are the arcs of every reached vertex. Only
+    // the counting pass converts the distances back for the check; the
+    // timed pass is the search alone.
+    TypedGraphView<uint16_t, uint32_t> typed(graph);
+    benchmarkEngine(csv, spec, arcs, "typed_uint16_uint32", sources, expected, options,
+        [&](int q, auto&& trace) {
+            vector<uint32_t> dist = typed.dijkstra(sources[q]).first;
+            if constexpr (!is_same_v<decay_t<decltype(trace)>, CountingTrace>) return vector<int>();
+            vector<int> converted(dist.size());
+            for (size_t v = 0; v < dist.size(); v++) {
+                bool reached = dist[v] != DistanceTraits<uint32_t>::unreachable();
+                converted[v] = reached ? (int)dist[v] : INT_MAX;
+                if constexpr (is_same_v<decay_t<decltype(trace)>, CountingTrace>) {
+                    if (reached) trace.scanned += graph.adjacency().degree((int)v);
+                }
+            }
+            return converted;
+        });
+
+    // Point-to-point engines: source q to targets[q], checked against the
+    // reference distance; each run returns { distance }
+    vector<int> targets;
+    vector<vector<int>> expectedToTarget;
+    for (int q = 0; q < options.queries; q++) {
+        targets.push_back((int)(rng() % spec.vertices));
+        expectedToTarget.push_back({ expected[q][targets.back()] });
+    }
+    benchmarkEngine(csv, spec, arcs, "bidirectional", sources, expectedToTarget, options,
+        [&](int q, auto&& trace) { return vector<int>{ graph.shortestPath(sources[q], targets[q], trace).distance }; });
+
+    if (spec.vertices <= options.chMaxVertices && spec.family != "power_law") {
+        auto start = chrono::steady_clock::now();
+        ContractionHierarchy hierarchy(graph);
+        double buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        writeRow(csv, spec, arcs, "contraction_hierarchy_build", 0, 0, buildMs, true, options);
+        benchmarkEngine(csv, spec, arcs, "contraction_hierarchy", sources, expectedToTarget, options,
+            [&](int q, auto&& trace) {
+                PathResult result = hierarchy.query(sources[q], targets[q]);
+                if constexpr (is_same_v<decay_t<decltype(trace)>, CountingTrace>) trace.scanned += result.settledVertices;
+                return vector<int>{ result.distance };
+            });
+    }
+
+    auto start = chrono::steady_clock::now();
+    LandmarkIndex landmarks(graph, options.landmarks);
+    double buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    writeRow(csv, spec, arcs, "alt_build", 0, 0, buildMs, true, options);
+    benchmarkEngine(csv, spec, arcs, "alt", sources, expectedToTarget, options,
+        [&](int q, auto&& trace) {
+            PathResult result = landmarks.query(graph, sources[q], targets[q]);
+            if constexpr (is_same_v<decay_t<decltype(trace)>, CountingTrace>) trace.scanned += result.settledVertices;
+            return vector<int>{ result.distance };
+        });
+}
+
+// Graphs are generated at 10^4, 10^5 and 10^6 vertices; --max-vertices
+// below the smallest scale would leave nothing to run
+const int kSmallestScale = 10000;
+
+void printUsage() {
+    cout << "Usage: DijkstraBenchmark [--seed N] [--queries N] [--max-vertices N]" << endl;
+    cout << "                         [--threads N] [--landmarks N] [--ch-max-vertices N]" << endl;
+    cout << "                         [--output file.csv]" << endl;
+}
+
+// The whole of text as a number of type Int, no sign or trailing characters
+template <class Int>
+bool parseNumber(const string& text, Int& value) {
+    auto parsed = from_chars(text.data(), text.data() + text.size(), value);
+    return parsed.ec == errc() && parsed.ptr == text.data() + text.size() && !text.empty() && text[0] != '-';
+}
+
+bool parseOptions(int argc, char* argv[], BenchmarkOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        string flag = argv[i];
+        if (i + 1 >= argc) {
+            cout << "Error: " << flag << " needs a value!" << endl;
+            printUsage();
+            return false;
+        }
+        string value = argv[++i];
+        bool valid = true;
+        if (flag == "--seed") valid = parseNumber(value, options.seed);
+        else if (flag == "--queries") valid = parseNumber(value, options.queries) && options.queries > 0;
+        else if (flag == "--max-vertices") valid = parseNumber(value, options.maxVertices) && options.maxVertices >= kSmallestScale;
+        else if (flag == "--threads") valid = parseNumber(value, options.threads);
+        else if (flag == "--landmarks") valid = parseNumber(value, options.landmarks) && options.landmarks > 0;
+        else if (flag == "--ch-max-vertices") valid = parseNumber(value, options.chMaxVertices);
+        else if (flag == "--output") options.output = value;
+        else {
+            cout << "Error: Unknown option " << flag << "!" << endl;
+            printUsage();
+            return false;
+        }
+        if (!valid) {
+            cout << "Error: Bad value \"" << value << "\" for " << flag << "!" << endl;
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            cout << "Error: Cannot write " << options.output << "!" << endl;
+            return 1;
+        }
+    }
+    ostream& csv = options.output.empty() ? cout : file;
+    csv << "family,vertices,arcs,engine,queries,relaxations,total_ms,ns_per_relaxation,"
+        << "queries_per_second,peak_rss_kb,agrees,seed" << endl;
+
+    ThreadPool pool(options.threads);
+    for (int scale : { kSmallestScale, 100000, 1000000 }) {
+        if (scale > options.maxVertices) break;
+        // Each family draws from its own generator, so adding a family or a
+        // scale leaves the other graphs unchanged
+        mt19937 gridRng(options.seed + 1), geometricRng(options.seed + 2);
+        mt19937 powerLawRng(options.seed + 3), roadRng(options.seed + 4);
+        benchmarkGraph(csv, makeGrid(scale, gridRng), pool, options);
+        benchmarkGraph(csv, makeGeometric(scale, geometricRng), pool, options);
+        benchmarkGraph(csv, makePowerLaw(scale, powerLawRng), pool, options);
+        benchmarkGraph(csv, makeRoadLike(scale, roadRng), pool, options);
+    }
+    return 0;
+}